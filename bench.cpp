@@ -0,0 +1,289 @@
+#include "bigint.hpp"
+#include "fptas.hpp"
+#include "standard.hpp"
+#include "instances.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+
+// Benchmark of the solvers over Pisinger's instance classes and of bigint.hpp
+// arithmetic. Results are written as JSON, one record per case; cases whose
+// predicted work is above max_work are recorded as skipped.
+
+using BigInteger = long long;
+using Rational = long double;
+using Clock = std::chrono::steady_clock;
+
+// one JSON object, values are already JSON literals
+using Record = std::vector<std::pair<std::string, std::string>>;
+
+struct Options {
+    std::string label;
+    size_t max_n;
+    std::vector<BigInteger> ranges;
+    double max_work;         // n * table size
+    double max_memory;       // bytes
+    size_t repetitions;
+    uint64_t seed;
+};
+
+struct Timing {
+    size_t repetitions;
+    double min_ms;
+    double mean_ms;
+};
+
+const std::vector<size_t> sizes = {100, 1000, 10000, 100000, 1000000};
+const std::vector<Rational> precisions = {0.5, 0.1, 0.01};
+// with the small range n / (eps * max_cost) >= 1 and the FPTAS runs the exact dp,
+// the large one is above n / eps for every size and precision so costs are really reduced
+const std::vector<BigInteger> default_ranges = {1000, 1000000000000};
+const std::vector<size_t> digit_counts = {10, 100, 1000, 10000};
+
+double ms_since(const Clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::string quote(const std::string& s) {
+    return "\"" + s + "\"";
+}
+
+template <typename Number>
+std::string number(const Number& value) {
+    std::ostringstream out;
+    out.precision(10);
+    out << value;
+    return out.str();
+}
+
+std::string to_json(const Record& record) {
+    std::string json = "{";
+    for (size_t i = 0; i < record.size(); ++i)
+        json += (i ? ", " : "") + quote(record[i].first) + ": " + record[i].second;
+    return json + "}";
+}
+
+// runs function repetitions times, the last result is stored in result
+template <typename Function, typename Result>
+Timing measure(Function function, size_t repetitions, Result& result) {
+    Timing timing{repetitions, 1e300, 0};
+    for (size_t i = 0; i < repetitions; ++i) {
+        auto start = Clock::now();
+        result = function();
+        double elapsed = ms_since(start);
+        timing.min_ms = std::min(timing.min_ms, elapsed);
+        timing.mean_ms += elapsed / repetitions;
+    }
+    return timing;
+}
+
+void add_timing(Record& record, const Timing& timing) {
+    record.push_back({"skipped", "false"});
+    record.push_back({"repetitions", number(timing.repetitions)});
+    record.push_back({"min_ms", number(timing.min_ms)});
+    record.push_back({"mean_ms", number(timing.mean_ms)});
+}
+
+void add_skipped(Record& record) {
+    record.push_back({"skipped", "true"});
+}
+
+bool is_affordable(double work, double memory, const Options& options) {
+    return work <= options.max_work && memory <= options.max_memory;
+}
+
+Record bench_optimal_cost(const instances::Instance& instance, Record record, const Options& options) {
+    size_t n = instance.weights.size();
+    bool subset_sum = subset_sum::is_subset_sum(instance.weights, instance.costs);
+    double table = subset_sum ? instance.max_weight / 64 + 1 : instance.max_weight + 1;
+    record.push_back({"work", number(n * table)});
+    if (!is_affordable(n * table, 8 * table, options)) {
+        add_skipped(record);
+        return record;
+    }
+
+    std::vector<standard::Item> items(n);
+    for (size_t i = 0; i < n; ++i)
+        items[i] = {instance.weights[i], instance.costs[i]};
+    BigInteger result;
+    add_timing(record, measure([&] { return standard::get_optimal_cost(n, instance.max_weight, items); },
+                               options.repetitions, result));
+    record.push_back({"result", number(result)});
+    return record;
+}
+
+Record bench_approximate_optimal_cost(const instances::Instance& instance, Rational precision, Record record, const Options& options) {
+    size_t n = instance.weights.size();
+    std::vector<fptas::Item> items = fptas::get_items(instance.max_weight, instance.weights, instance.costs);
+
+    auto start = Clock::now();
+    fptas::reduce_cost(items, precision);
+    double reduce_cost_ms = ms_since(start);
+
+    record.push_back({"reduction_coef", number(fptas::get_reduction_coef(items, precision))});
+
+    double states = fptas::get_max_states(items);
+    double memory = fptas::get_max_table_bytes(items);
+    if (subset_sum::is_subset_sum(instance.weights, instance.costs) && instance.max_weight / 64 <= states) {
+        states = instance.max_weight / 64 + 1;
+        memory = 8 * states;
+    }
+    record.push_back({"work", number(n * states)});
+    if (!is_affordable(n * states, memory, options)) {
+        add_skipped(record);
+        return record;
+    }
+
+    BigInteger result;
+    Timing timing = measure([&] {
+        return fptas::get_approximate_optimal_cost(instance.max_weight, precision, instance.weights, instance.costs);
+    }, options.repetitions, result);
+    add_timing(record, timing);
+    record.push_back({"result", number(result)});
+    record.push_back({"phases", "{\"reduce_cost_ms\": " + number(reduce_cost_ms) +
+                                ", \"dp_ms\": " + number(std::max(0.0, timing.min_ms - reduce_cost_ms)) + "}"});
+    return record;
+}
+
+Record bench_greedy_cost(const instances::Instance& instance, Record record, const Options& options) {
+    std::vector<fptas::Item> items = fptas::get_items(instance.max_weight, instance.weights, instance.costs);
+    BigInteger result;
+    add_timing(record, measure([&] { return fptas::get_greedy_cost(instance.max_weight, items); },
+                               options.repetitions, result));
+    record.push_back({"result", number(result)});
+    return record;
+}
+
+// all knapsack solvers on one instance of the class
+void bench_instance(const std::string& type, size_t n, BigInteger range, const Options& options, std::vector<Record>& records) {
+    instances::Instance instance = instances::generate(type, n, range, options.seed);
+    Record common = {{"class", quote(type)}, {"n", number(n)}, {"range", number(range)},
+                     {"max_weight", number(instance.max_weight)}};
+
+    Record record = {{"name", quote("get_optimal_cost")}};
+    record.insert(record.end(), common.begin(), common.end());
+    records.push_back(bench_optimal_cost(instance, record, options));
+    std::cerr << to_json(records.back()) << '\n';
+
+    for (Rational precision : precisions) {
+        record = {{"name", quote("get_approximate_optimal_cost")}};
+        record.insert(record.end(), common.begin(), common.end());
+        record.push_back({"eps", number(precision)});
+        records.push_back(bench_approximate_optimal_cost(instance, precision, record, options));
+        std::cerr << to_json(records.back()) << '\n';
+    }
+
+    record = {{"name", quote("get_greedy_cost")}};
+    record.insert(record.end(), common.begin(), common.end());
+    records.push_back(bench_greedy_cost(instance, record, options));
+    std::cerr << to_json(records.back()) << '\n';
+}
+
+std::vector<Record> bench_knapsack(const Options& options) {
+    std::vector<Record> records;
+    for (const auto& type : instances::classes)
+        for (BigInteger range : options.ranges)
+            for (size_t n : sizes)
+                if (n <= options.max_n)
+                    bench_instance(type, n, range, options, records);
+    return records;
+}
+
+bigint::BigInteger get_random_number(size_t digits, instances::Random& random) {
+    std::string decimal(digits, '0');
+    decimal[0] = '0' + random.from_to(1, 9);
+    for (size_t i = 1; i < digits; ++i)
+        decimal[i] = '0' + random.from_to(0, 9);
+    bigint::BigInteger ans;
+    ans.fromString(decimal);
+    return ans;
+}
+
+std::vector<Record> bench_bigint(const Options& options) {
+    using bigint::BigInteger;
+    using bigint::Rational;
+
+    std::vector<Record> records;
+    instances::Random random(options.seed);
+    for (size_t digits : digit_counts) {
+        BigInteger lhs = get_random_number(digits, random), rhs = get_random_number(digits, random);
+        BigInteger half = get_random_number(digits / 2, random);
+
+        auto add_record = [&](const std::string& name, const Timing& timing) {
+            Record record = {{"name", quote(name)}, {"digits", number(digits)}};
+            add_timing(record, timing);
+            records.push_back(record);
+            std::cerr << to_json(record) << '\n';
+        };
+
+        BigInteger big_result;
+        add_record("BigInteger::operator+", measure([&] { return lhs + rhs; }, options.repetitions, big_result));
+        add_record("BigInteger::operator*", measure([&] { return lhs * rhs; }, options.repetitions, big_result));
+        add_record("BigInteger::operator/", measure([&] { return lhs / half; }, options.repetitions, big_result));
+
+        // gcd in every Rational operation is quadratic per step, keep the sizes moderate
+        if (digits > 1000)
+            continue;
+        Rational first(lhs, half), second(rhs, half + 1);
+        Rational rational_result;
+        bool compare_result;
+        add_record("Rational::operator+", measure([&] { return first + second; }, options.repetitions, rational_result));
+        add_record("Rational::operator<", measure([&] { return first < second; }, options.repetitions, compare_result));
+    }
+    return records;
+}
+
+// usage: ./bench [label=NAME] [out=FILE] [max_n=N] [range=R] [max_work=UNITS] [max_memory=BYTES]
+//                [repetitions=K] [seed=S] [suite=all|knapsack|bigint]
+// range=R replaces the default ranges by one
+int main(int argc, char* argv[]) {
+    std::map<std::string, std::string> params;
+    for (int i = 1; i < argc; i++) {
+        std::string s = std::string(argv[i]);
+        if (s.find('=') != std::string::npos) {
+            auto pos = s.find('=');
+            params[s.substr(0, pos)] = s.substr(pos + 1);
+        }
+    }
+
+    Options options;
+    options.label = params.count("label") ? params["label"] : "";
+    options.max_n = params.count("max_n") ? std::stoull(params["max_n"]) : 1000000;
+    options.ranges = params.count("range") ? std::vector<BigInteger>{std::stoll(params["range"])} : default_ranges;
+    options.max_work = params.count("max_work") ? std::stod(params["max_work"]) : 2e9;
+    options.max_memory = params.count("max_memory") ? std::stod(params["max_memory"]) : 1e9;
+    options.repetitions = params.count("repetitions") ? std::stoull(params["repetitions"]) : 3;
+    options.seed = params.count("seed") ? std::stoull(params["seed"]) : 1;
+    std::string suite = params.count("suite") ? params["suite"] : "all";
+
+    std::vector<Record> records;
+    if (suite == "all" || suite == "knapsack")
+        records = bench_knapsack(options);
+    if (suite == "all" || suite == "bigint") {
+        std::vector<Record> bigint_records = bench_bigint(options);
+        records.insert(records.end(), bigint_records.begin(), bigint_records.end());
+    }
+
+    std::ostringstream json;
+    json << "{\n  \"label\": " << quote(options.label)
+         << ",\n  \"seed\": " << options.seed
+         << ",\n  \"max_work\": " << number(options.max_work)
+         << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < records.size(); ++i)
+        json << "    " << to_json(records[i]) << (i + 1 < records.size() ? ",\n" : "\n");
+    json << "  ]\n}\n";
+
+    if (params.count("out")) {
+        std::ofstream out(params["out"]);
+        out << json.str();
+    } else {
+        std::cout << json.str();
+    }
+
+    return 0;
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#include "subset_sum.hpp"
+#include "stats.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace fptas {
+
+// number types  ------
+
+using BigInteger = long long;
+using Rational = long double;
+
+// number types  ------
+
+struct DpState {
+    BigInteger min_weight;
+    BigInteger cost;
+};
+
+struct Item {
+    BigInteger weight;
+    BigInteger cost;
+    size_t reduced_cost; // used as index in dp
+};
+
+inline void update_state(DpState& dest_state, const DpState& source_state, const Item& item) {
+    if (dest_state.min_weight == -1 || dest_state.min_weight > source_state.min_weight + item.weight) {
+        dest_state.min_weight = source_state.min_weight + item.weight;
+        dest_state.cost = source_state.cost + item.cost;
+        STATS_ADD(states_relaxed, 1);
+    }
+}
+
+inline void resize_for_update(std::vector<DpState>& dp, const BigInteger& max_weight, const Item& item) {
+    STATS_PHASE(resize_for_update_ms);
+    size_t max_reduced_cost = dp.size();
+    for (size_t i = 0; i < dp.size(); ++i)
+        if (dp[i].min_weight != -1 && dp[i].min_weight + item.weight <= max_weight)
+            max_reduced_cost = std::max(max_reduced_cost, i + item.reduced_cost + 1);
+#ifdef KNAPSACK_STATS
+    size_t old_capacity = dp.capacity();
+#endif
+    dp.resize(max_reduced_cost, DpState{-1, 0});
+#ifdef KNAPSACK_STATS
+    if (dp.capacity() != old_capacity) {
+        STATS_ADD(reallocations, 1);
+        STATS_ADD(bytes_allocated, dp.capacity() * sizeof(DpState));
+    }
+    STATS_MAX(peak_dp_length, dp.size());
+#endif
+}
+
+inline void update_states(std::vector<DpState>& dp, const BigInteger& max_weight, const Item& item) {
+    STATS_PHASE(update_states_ms);
+    long long old_size = dp.size();
+    resize_for_update(dp, max_weight, item);
+    STATS_ADD(states_touched, old_size);
+    for (long long i = old_size - 1; i >= 0; --i) {
+        if (dp[i].min_weight != -1 && dp[i].min_weight + item.weight <= max_weight) {
+            update_state(dp[i + item.reduced_cost], dp[i], item);
+        }
+    }
+}
+
+// O(n^3/eps) time & O(n^2/eps) memory
+inline BigInteger solve_reduced_problem(
+            const BigInteger& max_weight,
+            const std::vector<Item>& items) {
+
+    std::vector<DpState> dp_least_weight = {DpState{0, 0}};
+    STATS_ADD(bytes_allocated, sizeof(DpState));
+
+    for (const auto& item : items) {
+        update_states(dp_least_weight, max_weight, item);
+    }
+
+    BigInteger best_cost = 0;
+    for (const auto& state : dp_least_weight) {
+        if (state.min_weight != -1)
+            best_cost = std::max(best_cost, state.cost);
+    }
+    return best_cost;
+}
+
+inline Rational get_reduction_coef(
+            const std::vector<Item>& items,
+            const Rational& precision) {
+
+    // reduction_coef = n / (precision * max_cost)
+    size_t n = items.size();
+    BigInteger max_cost = 0;
+    for (const auto& item : items) {
+        max_cost = std::max(max_cost, item.cost);
+    }
+
+    if (precision == 0 || max_cost == 0 || n / (precision * max_cost) >= 1)  // Reduction won't help
+        return 1;
+    return n / (precision * max_cost);
+}
+
+inline void set_reduced_cost(
+            std::vector<Item>& items,
+            const Rational& reduction_coef) {
+
+    for (auto& item : items) {
+        item.reduced_cost = std::floor(item.cost * reduction_coef);
+    }
+}
+
+inline void reduce_cost(
+            std::vector<Item>& items,
+            const Rational& precision) {
+
+    STATS_PHASE(reduce_cost_ms);
+
+    // reduced_cost = floor(cost * n / (precision * max_cost))
+    Rational reduction_coef = get_reduction_coef(items, precision);
+    STATS_SET(reduction_coef, reduction_coef);
+    set_reduced_cost(items, reduction_coef);
+}
+
+// dp never has more states than 1 + sum of reduced costs,
+// summed in Rational since the sum may not fit into BigInteger
+inline Rational get_max_states(const std::vector<Item>& items) {
+    Rational max_states = 1;
+    for (const auto& item : items)
+        max_states += item.reduced_cost;
+    return max_states;
+}
+
+// upper bound on memory of dp_least_weight: vector growth doubles capacity up to 2 * states,
+// and the old buffer is still alive while it is copied into the new one, x3 in total
+inline Rational get_max_table_bytes(const std::vector<Item>& items) {
+    return 3 * Rational(sizeof(DpState)) * get_max_states(items);
+}
+
+// Greedy by cost / weight or the best single item, whichever is better: OUTPUT >= OPT / 2
+// O(n log n) time & O(n) memory
+const Rational greedy_precision = 0.5;
+
+inline BigInteger get_greedy_cost(
+            const BigInteger& max_weight,
+            std::vector<Item> items) {
+
+    // zero-weight items are always taken and zero-cost ones never help: the rest have
+    // positive density, compared exactly so the order is a strict weak ordering
+    BigInteger free_cost = 0;
+    items.erase(std::remove_if(items.begin(), items.end(), [&](const Item& item) {
+        if (item.weight == 0)
+            free_cost += item.cost;
+        return item.weight == 0 || item.cost == 0;
+    }), items.end());
+
+    std::sort(items.begin(), items.end(), [](const Item& lhs, const Item& rhs) {
+        return (unsigned __int128)lhs.cost * rhs.weight > (unsigned __int128)rhs.cost * lhs.weight;
+    });
+
+    BigInteger weight = 0, cost = 0, best_item = 0;
+    for (const auto& item : items) {
+        if (item.weight > max_weight)
+            continue;
+        best_item = std::max(best_item, item.cost);
+        if (weight + item.weight <= max_weight) {
+            weight += item.weight;
+            cost += item.cost;
+        }
+    }
+    return free_cost + std::max(cost, best_item);
+}
+
+// Smallest precision >= the requested one whose table fits into memory_budget bytes,
+// -1 if even greedy_precision does not fit
+// O(n log(1/eps))
+inline Rational fit_precision(
+            std::vector<Item> items,
+            const Rational& precision,
+            const BigInteger& memory_budget) {
+
+    // probes are not counted as reduce_cost in the stats
+    auto fits = [&](const Rational& eps) {
+        set_reduced_cost(items, get_reduction_coef(items, eps));
+        return get_max_table_bytes(items) <= memory_budget;
+    };
+
+    if (fits(precision))
+        return precision;
+    if (precision >= greedy_precision || !fits(greedy_precision))
+        return -1;
+
+    Rational lo = precision, hi = greedy_precision;
+    for (int iteration = 0; iteration < 64; ++iteration) {
+        Rational mid = (lo + hi) / 2;
+        if (fits(mid))
+            hi = mid;
+        else
+            lo = mid;
+    }
+    return hi;
+}
+
+// Items heavier than the knapsack never fit; left in, they would inflate max_cost
+// in reduce_cost and the rounding error would no longer be bounded by eps * OPT
+inline std::vector<Item> get_items(
+            const BigInteger& max_weight,
+            const std::vector<BigInteger>& weights,
+            const std::vector<BigInteger>& costs) {
+
+    std::vector<Item> items;
+    for (size_t i = 0; i < weights.size(); i++) {
+        if (weights[i] <= max_weight)
+            items.push_back(Item{weights[i], costs[i], 0});
+    }
+    return items;
+}
+
+inline BigInteger solve_with_precision(
+            const BigInteger& max_weight,
+            const Rational& precision,
+            const std::vector<BigInteger>& weights,
+            const std::vector<BigInteger>& costs,
+            std::vector<Item>& items) {
+
+    STATS_SET(precision, precision);
+
+    // calc reduced cost
+    reduce_cost(items, precision);
+
+    // subset-sum: the exact bitset is cheaper than the reduced dp when it has fewer words than dp has states
+    if (subset_sum::is_subset_sum(weights, costs) &&
+            subset_sum::get_bitset_capacity(max_weight, weights) / 64 <= get_max_states(items))
+        return subset_sum::get_max_subset_sum(max_weight, weights);
+
+    return solve_reduced_problem(max_weight, items);
+}
+
+inline BigInteger get_approximate_optimal_cost(
+            const BigInteger& max_weight,
+            const Rational& precision,
+            const std::vector<BigInteger>& weights,
+            const std::vector<BigInteger>& costs) {
+
+    std::vector<Item> items = get_items(max_weight, weights, costs);
+    return solve_with_precision(max_weight, precision, weights, costs, items);
+}
+
+// Same, but the dp table stays within memory_budget bytes: precision is degraded
+// to the smallest one that fits, down to the greedy. The precision actually
+// guaranteed is written to effective_precision.
+inline BigInteger get_approximate_optimal_cost(
+            const BigInteger& max_weight,
+            const Rational& precision,
+            const BigInteger& memory_budget,
+            const std::vector<BigInteger>& weights,
+            const std::vector<BigInteger>& costs,
+            Rational& effective_precision) {
+
+    // subset-sum: the exact bitset needs no degradation if it fits
+    if (subset_sum::is_subset_sum(weights, costs) &&
+            subset_sum::get_bitset_bytes(max_weight, weights) <= memory_budget) {
+        effective_precision = 0;
+        STATS_SET(precision, effective_precision);
+        return subset_sum::get_max_subset_sum(max_weight, weights);
+    }
+
+    std::vector<Item> items = get_items(max_weight, weights, costs);
+    effective_precision = fit_precision(items, precision, memory_budget);
+    if (effective_precision < 0) {
+        effective_precision = greedy_precision;
+        STATS_SET(precision, effective_precision);
+        STATS_SET(reduction_coef, 0);  // costs are not reduced
+        return get_greedy_cost(max_weight, items);
+    }
+    return solve_with_precision(max_weight, effective_precision, weights, costs, items);
+}
+
+} // namespace fptas
@@ -0,0 +1,247 @@
+#include "bigint.hpp"
+#include "fptas.hpp"
+#include "standard.hpp"
+#include "subset_sum.hpp"
+#include "instances.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+// In-process differential fuzzer: every case is solved by the exact dp and
+// checked against the other engines, (1 - eps) * OPT <= result <= OPT is
+// verified exactly in bigint::Rational. A failing case is shrunk before it is printed.
+
+using BigInteger = long long;
+using Clock = std::chrono::steady_clock;
+
+// eps = eps_numerator / eps_denominator is exact in long double
+const BigInteger eps_denominator = 1024;
+
+struct Case {
+    BigInteger max_weight;
+    BigInteger eps_numerator;
+    std::vector<BigInteger> weights;
+    std::vector<BigInteger> costs;
+};
+
+struct Options {
+    uint64_t seed;
+    size_t cases;
+    size_t threads;
+    size_t max_n;
+    BigInteger max_weight;
+    BigInteger max_cost;
+};
+
+bigint::Rational to_rational(BigInteger value) {
+    bigint::BigInteger ans;
+    ans.fromString(std::to_string(value));
+    return ans;
+}
+
+// smallest multiple of 2^-62 not below value, exact for every precision <= 1 the solver reports
+bigint::Rational to_rational_upper(long double value) {
+    const BigInteger scale = 1ll << 62;
+    return bigint::Rational(to_rational(BigInteger(std::ceil(value * scale)))) / to_rational(scale);
+}
+
+bigint::Rational get_eps(const Case& test) {
+    return bigint::Rational(to_rational(test.eps_numerator)) / to_rational(eps_denominator);
+}
+
+// (1 - eps) * optimal <= result <= optimal
+bool is_within_precision(BigInteger optimal, BigInteger result, const bigint::Rational& eps) {
+    bigint::Rational exact = to_rational(optimal), approximate = to_rational(result);
+    return (bigint::Rational(1) - eps) * exact <= approximate && approximate <= exact;
+}
+
+std::string to_string(const Case& test) {
+    std::ostringstream out;
+    out << test.weights.size() << ' ' << test.max_weight << '\n';
+    for (size_t i = 0; i < test.weights.size(); ++i)
+        out << test.weights[i] << ' ' << test.costs[i] << '\n';
+    out << test.eps_numerator << '/' << eps_denominator << '\n';
+    return out.str();
+}
+
+Case generate_case(uint64_t seed, size_t index, const Options& options) {
+    instances::Random random(seed, index);
+    size_t n = random.from_to(0, options.max_n);
+    Case test{random.from_to(0, options.max_weight), random.from_to(0, eps_denominator - 1), {}, {}};
+    if (random.from_to(0, 9) == 0)
+        test.eps_numerator = 0;
+
+    std::string type = instances::classes[random.from_to(0, instances::classes.size() - 1)];
+    BigInteger range = random.from_to(1, options.max_cost);
+    instances::Instance instance = instances::generate(type, n, range, random.next());
+    test.weights = instance.weights;
+    test.costs = instance.costs;
+    // the classes draw from [1, range]: in a quarter of the cases one item in 2..8
+    // gets a zero weight, a zero cost or both
+    if (random.from_to(0, 3) == 0) {
+        BigInteger one_in = random.from_to(2, 8);
+        for (size_t i = 0; i < n; ++i) {
+            if (random.from_to(1, one_in) != 1)
+                continue;
+            BigInteger zeros = random.from_to(0, 2);
+            if (zeros != 1)
+                test.weights[i] = 0;
+            if (zeros != 0)
+                test.costs[i] = 0;
+        }
+    }
+    if (random.from_to(0, 1) == 0)
+        test.max_weight = std::min(test.max_weight, instance.max_weight);
+    return test;
+}
+
+// empty if every engine agrees with the exact dp
+std::string check(const Case& test) {
+    size_t n = test.weights.size();
+    std::vector<standard::Item> items(n);
+    for (size_t i = 0; i < n; ++i)
+        items[i] = {test.weights[i], test.costs[i]};
+    std::vector<BigInteger> best_cost = standard::get_best_costs(test.max_weight, items);
+    BigInteger optimal = *std::max_element(best_cost.begin(), best_cost.end());
+
+    BigInteger result = standard::get_optimal_cost(n, test.max_weight, items);
+    if (result != optimal)
+        return "get_optimal_cost = " + std::to_string(result) + ", expected " + std::to_string(optimal);
+
+    if (subset_sum::is_subset_sum(test.weights, test.costs)) {
+        result = subset_sum::get_max_subset_sum(test.max_weight, test.weights, 1);
+        if (result != optimal)
+            return "get_max_subset_sum = " + std::to_string(result) + ", expected " + std::to_string(optimal);
+
+        // the block-parallel variant from one word on, so blocks are a few words and every boundary is hit
+        size_t threads = 2 + test.eps_numerator % 3;
+        result = subset_sum::get_max_subset_sum(test.max_weight, test.weights, threads, 1);
+        if (result != optimal)
+            return "get_max_subset_sum with " + std::to_string(threads) + " threads = " + std::to_string(result) +
+                   ", expected " + std::to_string(optimal);
+    }
+
+    bigint::Rational eps = get_eps(test);
+    fptas::Rational precision = fptas::Rational(test.eps_numerator) / eps_denominator;
+    result = fptas::get_approximate_optimal_cost(test.max_weight, precision, test.weights, test.costs);
+    if (!is_within_precision(optimal, result, eps))
+        return "get_approximate_optimal_cost = " + std::to_string(result) + ", optimal " + std::to_string(optimal);
+
+    // a budget of a few states forces the precision search and the greedy fallback
+    fptas::Rational effective_precision;
+    BigInteger memory_budget = 2 * sizeof(fptas::DpState) * (n * n + 1) / (1 + test.eps_numerator % 8);
+    result = fptas::get_approximate_optimal_cost(test.max_weight, precision, memory_budget,
+                                                 test.weights, test.costs, effective_precision);
+    if (!is_within_precision(optimal, result, to_rational_upper(effective_precision)))
+        return "get_approximate_optimal_cost with memory_budget = " + std::to_string(result) + ", optimal " +
+               std::to_string(optimal) + ", effective precision " + std::to_string(double(effective_precision));
+
+    result = fptas::get_greedy_cost(test.max_weight, fptas::get_items(test.max_weight, test.weights, test.costs));
+    if (!is_within_precision(optimal, result, bigint::Rational(1, 2)))
+        return "get_greedy_cost = " + std::to_string(result) + ", optimal " + std::to_string(optimal);
+
+    return "";
+}
+
+// smaller cases derived from test: one item less, halved capacity, halved weight or cost
+std::vector<Case> get_shrink_candidates(const Case& test) {
+    std::vector<Case> candidates;
+    for (size_t i = 0; i < test.weights.size(); ++i) {
+        Case smaller = test;
+        smaller.weights.erase(smaller.weights.begin() + i);
+        smaller.costs.erase(smaller.costs.begin() + i);
+        candidates.push_back(smaller);
+    }
+    if (test.max_weight > 0) {
+        Case smaller = test;
+        smaller.max_weight /= 2;
+        candidates.push_back(smaller);
+    }
+    for (size_t i = 0; i < test.weights.size(); ++i) {
+        for (auto values : {&Case::weights, &Case::costs}) {
+            if ((test.*values)[i] == 0)
+                continue;
+            Case smaller = test;
+            (smaller.*values)[i] /= 2;
+            candidates.push_back(smaller);
+        }
+    }
+    return candidates;
+}
+
+// greedily takes any smaller case that still fails until none does
+Case shrink(Case test) {
+    bool shrunk = true;
+    while (shrunk) {
+        shrunk = false;
+        for (const auto& candidate : get_shrink_candidates(test)) {
+            if (!check(candidate).empty()) {
+                test = candidate;
+                shrunk = true;
+                break;
+            }
+        }
+    }
+    return test;
+}
+
+// usage: ./fuzz [seed=S] [cases=N] [threads=K] [max_n=N] [max_weight=W] [max_cost=C]
+// case i is generated from (seed, i) only, so a failure is reproducible with any threads
+int main(int argc, char* argv[]) {
+    std::map<std::string, std::string> params;
+    for (int i = 1; i < argc; i++) {
+        std::string s = std::string(argv[i]);
+        if (s.find('=') != std::string::npos) {
+            auto pos = s.find('=');
+            params[s.substr(0, pos)] = s.substr(pos + 1);
+        }
+    }
+
+    Options options;
+    options.seed = params.count("seed") ? std::stoull(params["seed"]) : 1;
+    options.cases = params.count("cases") ? std::stoull(params["cases"]) : 100000;
+    options.threads = params.count("threads") ? std::stoull(params["threads"]) : std::thread::hardware_concurrency();
+    options.max_n = params.count("max_n") ? std::stoull(params["max_n"]) : 30;
+    options.max_weight = params.count("max_weight") ? std::stoll(params["max_weight"]) : 500;
+    options.max_cost = params.count("max_cost") ? std::stoll(params["max_cost"]) : 10000;
+
+    auto start = Clock::now();
+    std::atomic<size_t> next_case(0);
+    std::atomic<bool> failed(false);
+    std::mutex report;
+
+    auto worker = [&]() {
+        for (size_t index = next_case++; index < options.cases && !failed; index = next_case++) {
+            Case test = generate_case(options.seed, index, options);
+            if (check(test).empty())
+                continue;
+            if (failed.exchange(true))
+                return;
+            Case shrunk = shrink(test);
+            std::lock_guard<std::mutex> lock(report);
+            std::cout << "FAIL case " << index << " seed " << options.seed << ": " << check(test) << '\n'
+                      << "shrunk: " << check(shrunk) << '\n' << to_string(shrunk);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < std::max<size_t>(1, options.threads); ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& thread : workers)
+        thread.join();
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    size_t done = std::min(options.cases, next_case.load());
+    std::cout << (failed ? "FAIL" : "OK") << " cases=" << done << " seconds=" << seconds
+              << " cases_per_second=" << done / seconds << '\n';
+
+    return failed ? 1 : 0;
+}
@@ -1,13 +1,90 @@
+#include "instances.hpp"
+
 #include <vector>
 #include <iostream>
 #include <map>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <limits>
+
+// usage: ./gen SEED n=N [max_weight=W cost=C] [class=NAME range=R] [precision=EPS] [subset_sum=1]
+//              [format=text|binary] [threads=K]
+// Without class: weights in [0, 5 * max(W / n, 1)), costs in [1, C], capacity W.
+// With class: one of instances::classes with values in [1, R], capacity half of the total
+// weight (clamped to int64) unless max_weight is given. An unknown class or R > instances::max_range
+// is an error.
+// The output depends only on the parameters and the seed, not on threads.
+//
+// binary format: "KNAPSACK", int64 n, int64 W, n pairs of int64 (weight, cost), double precision
 
 using std::string;
-using std::cout;
+using instances::BigInteger;
+
+const char binary_magic[8] = {'K', 'N', 'A', 'P', 'S', 'A', 'C', 'K'};
+
+struct Options {
+    uint64_t seed;
+    size_t n;
+    string type;
+    BigInteger max_weight;
+    BigInteger cost;
+    BigInteger range;
+    long double precision;
+    bool subset_sum;
+    bool binary;
+    size_t threads;
+};
+
+// calls function(block) for every block, blocks are taken by threads in any order
+template <typename Function>
+void for_each_block(size_t from, size_t to, size_t threads, Function function) {
+    std::atomic<size_t> next_block(from);
+    auto worker = [&]() {
+        for (size_t block = next_block++; block < to; block = next_block++)
+            function(block);
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& thread : workers)
+        thread.join();
+}
+
+void generate_block(const Options& options, size_t block,
+                    const std::vector<std::pair<BigInteger, BigInteger>>& spanner,
+                    std::vector<BigInteger>& weights, std::vector<BigInteger>& costs) {
+    size_t from = block * instances::block_size, to = std::min(options.n, from + instances::block_size);
+    if (!options.type.empty()) {
+        instances::generate_block(options.type, options.range, options.seed, block, spanner, weights, costs);
+    } else {
+        instances::Random random(options.seed, block);
+        BigInteger approximate_weight = std::max<BigInteger>(options.max_weight / BigInteger(options.n), 1);
+        for (size_t i = from; i < to; ++i) {
+            weights[i] = random.from_to(0, approximate_weight * 5 - 1);
+            costs[i] = random.from_to(1, options.cost);
+        }
+    }
+    if (options.subset_sum)
+        for (size_t i = from; i < to; ++i)
+            costs[i] = weights[i];
+}
+
+void append_text(string& out, BigInteger first, BigInteger second) {
+    char buffer[48];
+    char* end = std::to_chars(buffer, buffer + 20, first).ptr;
+    *end++ = ' ';
+    end = std::to_chars(end, end + 20, second).ptr;
+    *end++ = '\n';
+    out.append(buffer, end);
+}
 
-int rand_from_to(int lower, int upper) { // [ ]
-    int shift = rand() % (upper - lower + 1);
-    return lower + shift;
+void append_binary(string& out, BigInteger first, BigInteger second) {
+    out.append(reinterpret_cast<const char*>(&first), sizeof(first));
+    out.append(reinterpret_cast<const char*>(&second), sizeof(second));
 }
 
 int main(int argc, char* argv[]) {
@@ -20,20 +97,76 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    std::srand(atoi(argv[1]));
+    Options options;
+    options.seed = std::stoull(argv[1]);
+    options.n = std::stoull(params["n"]);
+    options.type = params.count("class") ? params["class"] : "";
+    options.max_weight = params.count("max_weight") ? std::stoll(params["max_weight"]) : -1;
+    options.cost = params.count("cost") ? std::stoll(params["cost"]) : 1;
+    options.range = params.count("range") ? std::stoll(params["range"]) : options.cost;
+    options.precision = params.count("precision") ? std::stold(params["precision"]) : 0.0;
+    options.subset_sum = params.count("subset_sum") && params["subset_sum"] == "1";
+    options.binary = params.count("format") && params["format"] == "binary";
+    options.threads = params.count("threads") ? std::stoull(params["threads"]) : 1;
+
+    if (!options.type.empty() && !instances::is_class(options.type)) {
+        std::fprintf(stderr, "gen: unknown class %s\n", options.type.c_str());
+        return 1;
+    }
+    if (!options.type.empty() && (options.range < 1 || options.range > instances::max_range)) {
+        std::fprintf(stderr, "gen: range must be in [1, %lld]\n", instances::max_range);
+        return 1;
+    }
+    if (options.n > 0 && options.max_weight / BigInteger(options.n) > std::numeric_limits<BigInteger>::max() / 5) {
+        std::fprintf(stderr, "gen: max_weight / n must be at most %lld\n", std::numeric_limits<BigInteger>::max() / 5);
+        return 1;
+    }
+
+    size_t n = options.n, blocks = instances::get_block_count(n);
+    std::vector<BigInteger> weights(n), costs(n);
+    std::vector<std::pair<BigInteger, BigInteger>> spanner;
+    if (options.type == "spanner")
+        spanner = instances::get_spanner(options.range, options.seed);
+    for_each_block(0, blocks, options.threads, [&](size_t block) {
+        generate_block(options, block, spanner, weights, costs);
+    });
 
-    int n = stoi(params["n"]);
-    int max_weight = stoi(params["max_weight"]);
-    long long cost = stoll(params["cost"]);
-    long double precision = 0.0;
-    if (params.count("precision"))
-        precision = std::stold(params["precision"]);
+    if (options.max_weight < 0)
+        options.max_weight = instances::get_half_weight(weights);
 
-    cout << n << " " << max_weight << "\n";
-    int approximate_weight = std::max(max_weight / n, 1);
-    for (int i = 0; i < n; i++) {
-        cout << rand() % (approximate_weight * 5) << " ";
-        cout << rand() % cost + 1 << "\n";
+    string header;
+    if (options.binary) {
+        header.append(binary_magic, sizeof(binary_magic));
+        append_binary(header, n, options.max_weight);
+    } else {
+        append_text(header, n, options.max_weight);
     }
-    cout << precision;
-}
\ No newline at end of file
+    std::fwrite(header.data(), 1, header.size(), stdout);
+
+    // blocks are formatted in parallel a round at a time and written in order
+    size_t round = std::max<size_t>(1, options.threads) * 4;
+    std::vector<string> formatted(round);
+    for (size_t first = 0; first < blocks; first += round) {
+        size_t last = std::min(blocks, first + round);
+        for_each_block(first, last, options.threads, [&](size_t block) {
+            string& out = formatted[block - first];
+            out.clear();
+            size_t from = block * instances::block_size, to = std::min(n, from + instances::block_size);
+            for (size_t i = from; i < to; ++i) {
+                if (options.binary)
+                    append_binary(out, weights[i], costs[i]);
+                else
+                    append_text(out, weights[i], costs[i]);
+            }
+        });
+        for (size_t block = first; block < last; ++block)
+            std::fwrite(formatted[block - first].data(), 1, formatted[block - first].size(), stdout);
+    }
+
+    if (options.binary) {
+        double precision = options.precision;
+        std::fwrite(&precision, sizeof(precision), 1, stdout);
+    } else {
+        std::printf("%.18Lg", options.precision);
+    }
+}
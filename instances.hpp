@@ -0,0 +1,172 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <tuple>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+// Instance classes from Pisinger, "Where are the hard knapsack problems?":
+// weights and costs are drawn from [1, range], the capacity is half of the total weight.
+
+namespace instances {
+
+using BigInteger = long long;
+
+struct Instance {
+    BigInteger max_weight;
+    std::vector<BigInteger> weights;
+    std::vector<BigInteger> costs;
+};
+
+const std::vector<std::string> classes = {
+    "uncorrelated",
+    "weakly_correlated",
+    "strongly_correlated",
+    "inverse_strongly_correlated",
+    "subset_sum",
+    "spanner",
+};
+
+// weights and costs go up to range + range / 10 (+ 9 after spanner rounding), this keeps them in BigInteger
+const BigInteger max_range = (std::numeric_limits<BigInteger>::max() - 10) / 11 * 10;
+
+inline bool is_class(const std::string& type) {
+    return std::find(classes.begin(), classes.end(), type) != classes.end();
+}
+
+inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256**, every (seed, stream) pair gives an independent sequence
+class Random {
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    explicit Random(uint64_t seed, uint64_t stream = 0) {
+        uint64_t mixed = seed;
+        mixed = splitmix64(mixed) ^ stream;
+        for (auto& word : state)
+            word = splitmix64(mixed);
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t shifted = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    BigInteger from_to(BigInteger lower, BigInteger upper) { // [ ]
+        return lower + BigInteger(next() % (uint64_t(upper - lower) + 1));
+    }
+};
+
+// Items are generated in blocks, each from its own stream, so an instance
+// depends only on the seed and not on how many threads generated it
+const size_t block_size = 1 << 16;
+const uint64_t spanner_stream = ~0ull;
+
+// (weight, cost) of one item of the class, spanner is handled separately
+inline std::pair<BigInteger, BigInteger> get_item(const std::string& type, BigInteger range, Random& random) {
+    if (type == "weakly_correlated") {
+        BigInteger weight = random.from_to(1, range);
+        return {weight, random.from_to(std::max<BigInteger>(1, weight - range / 10), weight + range / 10)};
+    }
+    if (type == "strongly_correlated" || type == "spanner") {
+        BigInteger weight = random.from_to(1, range);
+        return {weight, weight + range / 10};
+    }
+    if (type == "inverse_strongly_correlated") {
+        BigInteger cost = random.from_to(1, range);
+        return {cost + range / 10, cost};
+    }
+    if (type == "subset_sum") {
+        BigInteger weight = random.from_to(1, range);
+        return {weight, weight};
+    }
+    // uncorrelated
+    return {random.from_to(1, range), random.from_to(1, range)};
+}
+
+// spanner(v = 2, m = 10) over strongly correlated items: every item is a
+// multiple a in [1, m] of one of v small "spanner" items
+const size_t spanner_size = 2;
+const BigInteger spanner_multiplier = 10;
+
+inline std::vector<std::pair<BigInteger, BigInteger>> get_spanner(BigInteger range, uint64_t seed) {
+    Random random(seed, spanner_stream);
+    std::vector<std::pair<BigInteger, BigInteger>> spanner;
+    for (size_t i = 0; i < spanner_size; ++i) {
+        auto [weight, cost] = get_item("spanner", range, random);
+        spanner.push_back({(weight + spanner_multiplier - 1) / spanner_multiplier,
+                           (cost + spanner_multiplier - 1) / spanner_multiplier});
+    }
+    return spanner;
+}
+
+// fills items of the block into the preallocated weights and costs
+inline void generate_block(
+        const std::string& type, BigInteger range, uint64_t seed, size_t block,
+        const std::vector<std::pair<BigInteger, BigInteger>>& spanner,
+        std::vector<BigInteger>& weights, std::vector<BigInteger>& costs) {
+
+    Random random(seed, block);
+    size_t from = block * block_size, to = std::min(weights.size(), from + block_size);
+    for (size_t i = from; i < to; ++i) {
+        if (type == "spanner") {
+            auto [weight, cost] = spanner[random.from_to(0, spanner_size - 1)];
+            BigInteger multiplier = random.from_to(1, spanner_multiplier);
+            weights[i] = weight * multiplier;
+            costs[i] = cost * multiplier;
+        } else {
+            std::tie(weights[i], costs[i]) = get_item(type, range, random);
+        }
+    }
+}
+
+inline size_t get_block_count(size_t n) {
+    return (n + block_size - 1) / block_size;
+}
+
+// half of the total weight, summed in 128 bits and clamped to BigInteger
+inline BigInteger get_half_weight(const std::vector<BigInteger>& weights) {
+    unsigned __int128 total_weight = 0;
+    for (const auto& weight : weights)
+        total_weight += weight;
+    return BigInteger(std::min<unsigned __int128>(total_weight / 2, std::numeric_limits<BigInteger>::max()));
+}
+
+// throws std::invalid_argument for an unknown class or a range above max_range
+inline Instance generate(const std::string& type, size_t n, BigInteger range, uint64_t seed) {
+    if (!is_class(type))
+        throw std::invalid_argument("unknown class " + type);
+    if (range < 1 || range > max_range)
+        throw std::invalid_argument("range must be in [1, max_range]");
+
+    Instance instance{0, std::vector<BigInteger>(n), std::vector<BigInteger>(n)};
+    std::vector<std::pair<BigInteger, BigInteger>> spanner = get_spanner(range, seed);
+    for (size_t block = 0; block < get_block_count(n); ++block)
+        generate_block(type, range, seed, block, spanner, instance.weights, instance.costs);
+
+    instance.max_weight = get_half_weight(instance.weights);
+    return instance;
+}
+
+} // namespace instances
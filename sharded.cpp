@@ -0,0 +1,318 @@
+#include "standard.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// Sharded exact solver: items are split between worker processes, every worker
+// runs the O(nW) dp on its shard and sends back its frontier, the coordinator
+// merges the frontiers with a (max,+) convolution over capacity. The merges of
+// one level of the merge tree are independent and are forked the same way.
+
+using standard::BigInteger;
+using standard::Item;
+using Clock = std::chrono::steady_clock;
+
+// frontier[w] = best cost with total weight <= w, constant after the last element
+using Frontier = std::vector<BigInteger>;
+
+struct Shard {
+    std::vector<Item> items;
+    Frontier frontier;
+};
+
+struct ShardedRun {
+    size_t workers;              // after clamping to the number of items
+    BigInteger best_cost;
+    std::vector<double> shard_ms;
+    double merge_ms;
+    double total_ms;
+};
+
+double ms_since(const Clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void fail(const char* what) {
+    std::perror(what);
+    std::exit(1);
+}
+
+BigInteger frontier_at(const Frontier& frontier, BigInteger weight) {
+    return frontier[std::min(weight, BigInteger(frontier.size()) - 1)];
+}
+
+Frontier get_frontier(BigInteger max_weight, const std::vector<Item>& items) {
+    BigInteger capacity = 0;
+    for (const auto& item : items)
+        capacity = std::min(max_weight, capacity + item.weight);
+
+    Frontier frontier = standard::get_best_costs(capacity, items);
+    for (size_t w = 1; w < frontier.size(); ++w)
+        frontier[w] = std::max(frontier[w], frontier[w - 1]);
+    return frontier;
+}
+
+// weights where the frontier steps up, an optimal split always uses one of them
+std::vector<BigInteger> get_breakpoints(const Frontier& frontier) {
+    std::vector<BigInteger> breakpoints = {0};
+    for (size_t w = 1; w < frontier.size(); ++w)
+        if (frontier[w] > frontier[w - 1])
+            breakpoints.push_back(w);
+    return breakpoints;
+}
+
+bool is_concave(const Frontier& frontier) {
+    for (size_t w = 2; w < frontier.size(); ++w)
+        if (frontier[w] - frontier[w - 1] > frontier[w - 1] - frontier[w - 2])
+            return false;
+    return true;
+}
+
+// result[c] = max f[a] + g[c - a]; with g concave the best a is monotone in c
+// O(W log W)
+void combine_concave_rec(
+        const Frontier& f, const Frontier& g, Frontier& result,
+        BigInteger from, BigInteger to, BigInteger opt_from, BigInteger opt_to) {
+    if (from > to)
+        return;
+    BigInteger mid = (from + to) / 2;
+    BigInteger best_a = opt_from;
+    result[mid] = -1;
+    for (BigInteger a = opt_from; a <= std::min({opt_to, mid, BigInteger(f.size()) - 1}); ++a) {
+        BigInteger candidate = f[a] + frontier_at(g, mid - a);
+        if (candidate > result[mid]) {
+            result[mid] = candidate;
+            best_a = a;
+        }
+    }
+    combine_concave_rec(f, g, result, from, mid - 1, opt_from, best_a);
+    combine_concave_rec(f, g, result, mid + 1, to, best_a, opt_to);
+}
+
+// result[c] = max over breakpoints a of f[a] + g[c - a]
+// O(B * W), B = number of breakpoints of f
+void combine_bounded(const Frontier& f, const Frontier& g, Frontier& result) {
+    std::vector<BigInteger> breakpoints = get_breakpoints(f);
+    std::fill(result.begin(), result.end(), -1);
+    for (BigInteger a : breakpoints)
+        for (BigInteger c = a; c < BigInteger(result.size()); ++c)
+            result[c] = std::max(result[c], f[a] + frontier_at(g, c - a));
+}
+
+// result = f with the items put on top of it by the ordinary dp, used when
+// the other shard has fewer items than breakpoints
+// O(|items| * W)
+void combine_replay(const Frontier& f, const std::vector<Item>& items, Frontier& result) {
+    for (size_t c = 0; c < result.size(); ++c)
+        result[c] = frontier_at(f, c);
+    for (const auto& item : items)
+        for (BigInteger w = BigInteger(result.size()) - 1; w >= item.weight; --w)
+            result[w] = std::max(result[w], result[w - item.weight] + item.cost);
+}
+
+// (max,+) convolution of two shards' frontiers cut at max_weight,
+// by the cheapest of the methods above
+Shard combine(const Shard& f, const Shard& g, BigInteger max_weight) {
+    Shard merged;
+    merged.items = f.items;
+    merged.items.insert(merged.items.end(), g.items.begin(), g.items.end());
+
+    BigInteger capacity = std::min(max_weight, BigInteger(f.frontier.size() + g.frontier.size()) - 2);
+    merged.frontier.resize(capacity + 1);
+    if (is_concave(g.frontier)) {
+        combine_concave_rec(f.frontier, g.frontier, merged.frontier, 0, capacity, 0, capacity);
+        return merged;
+    }
+    if (is_concave(f.frontier)) {
+        combine_concave_rec(g.frontier, f.frontier, merged.frontier, 0, capacity, 0, capacity);
+        return merged;
+    }
+
+    // both methods cost O(W) per unit: a breakpoint of one side or an item of one side
+    const Shard& fewer_breakpoints = get_breakpoints(f.frontier).size() <= get_breakpoints(g.frontier).size() ? f : g;
+    const Shard& fewer_items = f.items.size() <= g.items.size() ? f : g;
+    if (fewer_items.items.size() < get_breakpoints(fewer_breakpoints.frontier).size()) {
+        const Shard& base = &fewer_items == &f ? g : f;
+        combine_replay(base.frontier, fewer_items.items, merged.frontier);
+    } else {
+        const Shard& other = &fewer_breakpoints == &f ? g : f;
+        combine_bounded(fewer_breakpoints.frontier, other.frontier, merged.frontier);
+    }
+    return merged;
+}
+
+// only the value at max_weight is needed from the last combine
+// O(W)
+BigInteger combine_at(const Frontier& f, const Frontier& g, BigInteger max_weight) {
+    BigInteger best_cost = 0;
+    for (BigInteger a = 0; a < BigInteger(f.size()) && a <= max_weight; ++a)
+        best_cost = std::max(best_cost, f[a] + frontier_at(g, max_weight - a));
+    return best_cost;
+}
+
+void write_all(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written <= 0)
+            fail("write");
+        bytes += written;
+        size -= written;
+    }
+}
+
+void read_all(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = read(fd, bytes, size);
+        if (got <= 0)
+            fail("read");
+        bytes += got;
+        size -= got;
+    }
+}
+
+// forks a worker computing a frontier, it comes back through read_fd
+template <typename Compute>
+pid_t spawn_worker(Compute compute, int& read_fd) {
+    int fds[2];
+    if (pipe(fds) != 0)
+        fail("pipe");
+    pid_t pid = fork();
+    if (pid < 0)
+        fail("fork");
+    if (pid == 0) {
+        close(fds[0]);
+        auto start = Clock::now();
+        Frontier frontier = compute();
+        double time_ms = ms_since(start);
+        size_t size = frontier.size();
+        write_all(fds[1], &time_ms, sizeof(time_ms));
+        write_all(fds[1], &size, sizeof(size));
+        write_all(fds[1], frontier.data(), size * sizeof(BigInteger));
+        _exit(0);
+    }
+    close(fds[1]);
+    read_fd = fds[0];
+    return pid;
+}
+
+// returns the time the worker spent on its frontier
+double receive_frontier(int read_fd, Frontier& frontier) {
+    double time_ms;
+    size_t size;
+    read_all(read_fd, &time_ms, sizeof(time_ms));
+    read_all(read_fd, &size, sizeof(size));
+    frontier.resize(size);
+    read_all(read_fd, frontier.data(), size * sizeof(BigInteger));
+    close(read_fd);
+    return time_ms;
+}
+
+ShardedRun solve_sharded(BigInteger max_weight, const std::vector<Item>& items, size_t workers) {
+    auto start = Clock::now();
+    workers = std::max<size_t>(1, std::min(workers, items.size()));
+
+    std::vector<Shard> shards(workers);
+    std::vector<pid_t> pids(workers);
+    std::vector<int> fds(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        shards[i].items.assign(items.begin() + items.size() * i / workers,
+                               items.begin() + items.size() * (i + 1) / workers);
+        pids[i] = spawn_worker([&] { return get_frontier(max_weight, shards[i].items); }, fds[i]);
+    }
+
+    ShardedRun run;
+    run.workers = workers;
+    for (size_t i = 0; i < workers; ++i) {
+        run.shard_ms.push_back(receive_frontier(fds[i], shards[i].frontier));
+        waitpid(pids[i], nullptr, 0);
+    }
+
+    auto merge_start = Clock::now();
+    while (shards.size() > 2) {
+        size_t pairs = shards.size() / 2;
+        std::vector<Shard> merged(pairs);
+        for (size_t i = 0; i < pairs; ++i) {
+            pids[i] = spawn_worker([&] { return combine(shards[2 * i], shards[2 * i + 1], max_weight).frontier; }, fds[i]);
+            merged[i].items = shards[2 * i].items;
+            merged[i].items.insert(merged[i].items.end(), shards[2 * i + 1].items.begin(), shards[2 * i + 1].items.end());
+        }
+        for (size_t i = 0; i < pairs; ++i) {
+            receive_frontier(fds[i], merged[i].frontier);
+            waitpid(pids[i], nullptr, 0);
+        }
+        if (shards.size() % 2 == 1)
+            merged.push_back(std::move(shards.back()));
+        shards.swap(merged);
+    }
+    if (shards.size() == 2)
+        run.best_cost = combine_at(shards[0].frontier, shards[1].frontier, max_weight);
+    else
+        run.best_cost = frontier_at(shards[0].frontier, max_weight);
+    run.merge_ms = ms_since(merge_start);
+    run.total_ms = ms_since(start);
+    return run;
+}
+
+void report(const ShardedRun& run, double single_worker_ms) {
+    std::cerr << "workers=" << run.workers << " shard_ms=";
+    for (size_t i = 0; i < run.shard_ms.size(); ++i)
+        std::cerr << (i ? "," : "") << run.shard_ms[i];
+    std::cerr << " merge_ms=" << run.merge_ms << " total_ms=" << run.total_ms;
+    if (single_worker_ms > 0)
+        std::cerr << " speedup=" << single_worker_ms / run.total_ms;
+    std::cerr << '\n';
+}
+
+// usage: ./sharded [workers=K] [sweep=K] < in
+// sweep=K runs 1, 2, 4, ..., K workers and reports the speedup over 1 worker
+int main(int argc, char* argv[]) {
+    std::map<std::string, std::string> params;
+    for (int i = 1; i < argc; i++) {
+        std::string s = std::string(argv[i]);
+        if (s.find('=') != std::string::npos) {
+            auto pos = s.find('=');
+            params[s.substr(0, pos)] = s.substr(pos + 1);
+        }
+    }
+
+    int n;
+    BigInteger max_weight;
+    std::cin >> n >> max_weight;
+
+    std::vector<Item> items(n);
+    for (int i = 0; i < n; ++i) {
+        std::cin >> items[i].weight >> items[i].cost;
+    }
+
+    if (params.count("sweep")) {
+        size_t max_workers = std::stoul(params["sweep"]);
+        double single_worker_ms = 0;
+        BigInteger best_cost = 0;
+        for (size_t workers = 1; workers <= max_workers; workers *= 2) {
+            ShardedRun run = solve_sharded(max_weight, items, workers);
+            if (workers == 1)
+                single_worker_ms = run.total_ms;
+            report(run, single_worker_ms);
+            best_cost = run.best_cost;
+        }
+        std::cout << best_cost << '\n';
+        return 0;
+    }
+
+    size_t workers = params.count("workers") ? std::stoul(params["workers"]) : 1;
+    ShardedRun run = solve_sharded(max_weight, items, workers);
+    report(run, 0);
+    std::cout << run.best_cost << '\n';
+
+    return 0;
+}
@@ -0,0 +1,324 @@
+#include "fptas.hpp"
+#include "standard.hpp"
+#include "subset_sum.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cmath>
+
+#include <unistd.h>
+
+// Front end choosing between the engines: the instance is profiled, the running
+// time and memory of every engine are predicted by a cost model and the cheapest
+// engine is run. The decision is logged to stderr next to the actual time.
+
+using BigInteger = long long;
+using Rational = long double;
+using Clock = std::chrono::steady_clock;
+
+struct Instance {
+    BigInteger max_weight;
+    Rational precision;
+    std::vector<BigInteger> weights;
+    std::vector<BigInteger> costs;
+};
+
+struct Profile {
+    size_t n;
+    size_t effective_n;        // after duplicates are merged
+    BigInteger max_weight;
+    BigInteger capacity;       // min(W, sum of weights)
+    BigInteger max_cost;
+    double max_states;         // 1 + sum of reduced costs, may not fit into BigInteger
+    bool subset_sum;
+    double duplicate_ratio;
+};
+
+// ns per unit of work, see get_work_units; greedy_ns is per n log2 n
+struct CostModel {
+    double standard_ns;
+    double subset_sum_ns;
+    double fptas_ns;
+    double greedy_ns;
+};
+
+// measured with calibrate=1 on the reference machine
+const CostModel default_model = {1.7, 1.7, 2.5, 10.0};
+
+struct Prediction {
+    std::string engine;
+    double time_ms;
+    double memory_bytes;
+};
+
+const std::vector<std::string> engines = {"subset_sum", "standard", "fptas"};
+
+// precision degraded to fit memory_limit, run when no engine fits as is
+const std::string fallback_engine = "fptas_budget";
+
+double ms_since(const Clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// k copies of an item become pieces of 1, 2, 4, ..., rest copies:
+// every count 0..k is still a subset sum of pieces, so the optimum is the same.
+// At most W / weight copies fit, so no piece is heavier than W and weight * taken does not overflow;
+// items heavier than W are dropped. The number of distinct items is written to distinct.
+// O(n log n), one sort
+Instance compress_duplicates(const Instance& instance, size_t& distinct) {
+    std::vector<std::pair<BigInteger, BigInteger>> sorted;
+    sorted.reserve(instance.weights.size());
+    for (size_t i = 0; i < instance.weights.size(); ++i)
+        sorted.push_back({instance.weights[i], instance.costs[i]});
+    std::sort(sorted.begin(), sorted.end());
+
+    Instance compressed{instance.max_weight, instance.precision, {}, {}};
+    distinct = 0;
+    for (size_t first = 0, last = 0; first < sorted.size(); first = last) {
+        while (last < sorted.size() && sorted[last] == sorted[first])
+            ++last;
+        ++distinct;
+        const auto& item = sorted[first];
+        if (item.first > instance.max_weight)
+            continue;
+        BigInteger count = last - first;
+        BigInteger left = item.first == 0 ? count : std::min(count, instance.max_weight / item.first);
+        for (BigInteger piece = 1; left > 0; piece *= 2) {
+            BigInteger taken = std::min(piece, left);
+            compressed.weights.push_back(item.first * taken);
+            compressed.costs.push_back(item.second * taken);
+            left -= taken;
+        }
+    }
+    return compressed;
+}
+
+std::vector<fptas::Item> get_reduced_items(const Instance& instance) {
+    std::vector<fptas::Item> items = fptas::get_items(instance.max_weight, instance.weights, instance.costs);
+    fptas::reduce_cost(items, instance.precision);
+    return items;
+}
+
+// O(n) over the compressed instance, distinct comes from compress_duplicates
+Profile profile_instance(const Instance& instance, const Instance& compressed, size_t distinct) {
+    Profile profile;
+    profile.n = instance.weights.size();
+    profile.effective_n = compressed.weights.size();
+    profile.max_weight = instance.max_weight;
+    profile.capacity = subset_sum::get_bitset_capacity(compressed.max_weight, compressed.weights);
+    profile.max_cost = 0;
+    for (const auto& cost : instance.costs)
+        profile.max_cost = std::max(profile.max_cost, cost);
+    profile.max_states = fptas::get_max_states(get_reduced_items(compressed));
+    profile.subset_sum = subset_sum::is_subset_sum(compressed.weights, compressed.costs);
+    profile.duplicate_ratio = profile.n == 0 ? 0 : 1 - double(distinct) / profile.n;
+    return profile;
+}
+
+// every engine makes one pass over its table per item
+double get_work_units(const std::string& engine, const Profile& profile) {
+    double n = profile.effective_n;
+    if (engine == "subset_sum")
+        return n * (profile.capacity / 64 + 1);
+    if (engine == "standard")
+        return n * (profile.capacity + 1);
+    return n * profile.max_states;
+}
+
+double get_memory_bytes(const std::string& engine, const Profile& profile) {
+    if (engine == "subset_sum")
+        return 2 * 8.0 * (profile.capacity / 64 + 1);  // second buffer for the block-parallel variant
+    if (engine == "standard")
+        return 8.0 * (double(profile.capacity) + 1);
+    return 3 * double(sizeof(fptas::DpState)) * profile.max_states;  // see fptas::get_max_table_bytes
+}
+
+std::vector<Prediction> predict(const Profile& profile, const CostModel& model) {
+    std::vector<Prediction> predictions;
+    for (const auto& engine : engines) {
+        if (engine == "subset_sum" && !profile.subset_sum)
+            continue;
+        double ns = engine == "subset_sum" ? model.subset_sum_ns : engine == "standard" ? model.standard_ns : model.fptas_ns;
+        predictions.push_back({engine, get_work_units(engine, profile) * ns / 1e6, get_memory_bytes(engine, profile)});
+    }
+    return predictions;
+}
+
+// fallback_engine runs at the precision fit_precision picks for memory_limit,
+// or the greedy if even greedy_precision does not fit
+Prediction predict_fallback(const Instance& instance, const CostModel& model, double memory_limit, Rational& effective_precision) {
+    std::vector<fptas::Item> items = fptas::get_items(instance.max_weight, instance.weights, instance.costs);
+    double n = items.size();
+    effective_precision = fptas::fit_precision(items, instance.precision, BigInteger(memory_limit));
+    if (effective_precision < 0) {
+        effective_precision = fptas::greedy_precision;
+        return {fallback_engine, n * std::log2(n + 1) * model.greedy_ns / 1e6, 2 * n * sizeof(fptas::Item)};  // items and the sorted copy
+    }
+    fptas::reduce_cost(items, effective_precision);
+    double states = fptas::get_max_states(items);
+    return {fallback_engine, n * states * model.fptas_ns / 1e6, double(fptas::get_max_table_bytes(items))};
+}
+
+// physical memory of the machine, the default memory_limit
+double get_physical_memory() {
+    return double(sysconf(_SC_PHYS_PAGES)) * sysconf(_SC_PAGE_SIZE);
+}
+
+BigInteger run_engine(const std::string& engine, const Instance& instance, const Profile& profile, double memory_limit) {
+    if (engine == "subset_sum")
+        return subset_sum::get_max_subset_sum(profile.capacity, instance.weights);
+
+    if (engine == "standard") {
+        std::vector<standard::Item> items(instance.weights.size());
+        for (size_t i = 0; i < items.size(); ++i)
+            items[i] = {instance.weights[i], instance.costs[i]};
+        std::vector<BigInteger> best_cost = standard::get_best_costs(profile.capacity, items);
+        return *std::max_element(best_cost.begin(), best_cost.end());
+    }
+
+    if (engine == fallback_engine) {
+        Rational effective_precision;
+        BigInteger best_cost = fptas::get_approximate_optimal_cost(profile.capacity, instance.precision, BigInteger(memory_limit),
+                                                                   instance.weights, instance.costs, effective_precision);
+        std::cerr << "effective_precision=" << effective_precision << '\n';
+        return best_cost;
+    }
+
+    return fptas::solve_reduced_problem(profile.capacity, get_reduced_items(instance));
+}
+
+Instance get_random_instance(size_t n, BigInteger max_weight, BigInteger max_cost, Rational precision, bool subset_sum) {
+    std::mt19937_64 random(n);
+    Instance instance{max_weight, precision, std::vector<BigInteger>(n), std::vector<BigInteger>(n)};
+    for (size_t i = 0; i < n; ++i) {
+        instance.weights[i] = random() % (4 * max_weight / n) + 1;
+        instance.costs[i] = subset_sum ? instance.weights[i] : BigInteger(random() % max_cost) + 1;
+    }
+    return instance;
+}
+
+// times every engine on a small random instance
+// O(1) instances, ~0.1 s
+CostModel calibrate() {
+    auto measure = [](const std::string& engine, const Instance& instance) {
+        size_t distinct;
+        Instance compressed = compress_duplicates(instance, distinct);
+        Profile profile = profile_instance(instance, compressed, distinct);
+        auto start = Clock::now();
+        run_engine(engine, compressed, profile, get_physical_memory());
+        return ms_since(start) * 1e6 / get_work_units(engine, profile);
+    };
+    CostModel model;
+    model.standard_ns = measure("standard", get_random_instance(500, 50000, 10000, 0, false));
+    model.subset_sum_ns = measure("subset_sum", get_random_instance(500, 1 << 22, 0, 0, true));
+    model.fptas_ns = measure("fptas", get_random_instance(100, 1000000, 1000000, 0.5, false));
+
+    Instance instance = get_random_instance(100000, 1000000, 1000000, 0, false);
+    std::vector<fptas::Item> items = fptas::get_items(instance.max_weight, instance.weights, instance.costs);
+    auto start = Clock::now();
+    fptas::get_greedy_cost(instance.max_weight, items);
+    model.greedy_ns = ms_since(start) * 1e6 / (items.size() * std::log2(items.size() + 1));
+    return model;
+}
+
+// gen format=binary: "KNAPSACK", int64 n, int64 W, n pairs of int64 (weight, cost), double precision
+void read_binary(std::istream& in, Instance& instance) {
+    char magic[8];
+    BigInteger n;
+    double precision;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&n), sizeof(n));
+    in.read(reinterpret_cast<char*>(&instance.max_weight), sizeof(instance.max_weight));
+    instance.weights.resize(n);
+    instance.costs.resize(n);
+    for (BigInteger i = 0; i < n; ++i) {
+        in.read(reinterpret_cast<char*>(&instance.weights[i]), sizeof(BigInteger));
+        in.read(reinterpret_cast<char*>(&instance.costs[i]), sizeof(BigInteger));
+    }
+    in.read(reinterpret_cast<char*>(&precision), sizeof(precision));
+    instance.precision = in ? precision : 0;
+}
+
+// usage: ./solve [calibrate=1] [memory_limit=BYTES] < in
+// engines predicted to use more than memory_limit bytes (physical memory by default) are not run,
+// if none fits, fptas runs with its precision degraded to fit the limit
+// input is the same as for main: n W, n lines "weight cost", precision (may be omitted, then 0),
+// or the binary output of gen
+int main(int argc, char* argv[]) {
+    std::map<std::string, std::string> params;
+    for (int i = 1; i < argc; i++) {
+        std::string s = std::string(argv[i]);
+        if (s.find('=') != std::string::npos) {
+            auto pos = s.find('=');
+            params[s.substr(0, pos)] = s.substr(pos + 1);
+        }
+    }
+
+    Instance instance;
+    if (std::cin.peek() == 'K') {
+        read_binary(std::cin, instance);
+    } else {
+        int n;
+        std::cin >> n >> instance.max_weight;
+        instance.weights.resize(n);
+        instance.costs.resize(n);
+        for (int i = 0; i < n; ++i) {
+            std::cin >> instance.weights[i] >> instance.costs[i];
+        }
+        if (!(std::cin >> instance.precision))
+            instance.precision = 0;
+    }
+
+    double memory_limit = params.count("memory_limit") ? std::stod(params["memory_limit"]) : get_physical_memory();
+
+    CostModel model = default_model;
+    if (params.count("calibrate") && params["calibrate"] == "1") {
+        model = calibrate();
+        std::cerr << "calibrate standard_ns=" << model.standard_ns << " subset_sum_ns=" << model.subset_sum_ns
+                  << " fptas_ns=" << model.fptas_ns << " greedy_ns=" << model.greedy_ns << '\n';
+    }
+
+    auto start = Clock::now();
+    size_t distinct;
+    Instance compressed = compress_duplicates(instance, distinct);
+    Profile profile = profile_instance(instance, compressed, distinct);
+    double profile_ms = ms_since(start);
+    std::cerr << "profile n=" << profile.n << " effective_n=" << profile.effective_n
+              << " max_weight=" << profile.max_weight << " capacity=" << profile.capacity
+              << " max_cost=" << profile.max_cost << " max_states=" << profile.max_states
+              << " subset_sum=" << profile.subset_sum << " duplicate_ratio=" << profile.duplicate_ratio
+              << " precision=" << instance.precision << " time_ms=" << profile_ms << '\n';
+
+    std::vector<Prediction> predictions = predict(profile, model);
+    Prediction best;
+    bool found = false;
+    for (const auto& prediction : predictions) {
+        bool fits = prediction.memory_bytes <= memory_limit;
+        std::cerr << "predict engine=" << prediction.engine << " time_ms=" << prediction.time_ms
+                  << " memory_bytes=" << prediction.memory_bytes << " fits=" << fits << '\n';
+        if (fits && (!found || prediction.time_ms < best.time_ms)) {
+            best = prediction;
+            found = true;
+        }
+    }
+    if (!found) {
+        Rational effective_precision;
+        best = predict_fallback(compressed, model, memory_limit, effective_precision);
+        std::cerr << "predict engine=" << best.engine << " time_ms=" << best.time_ms
+                  << " memory_bytes=" << best.memory_bytes << " effective_precision=" << effective_precision << '\n';
+    }
+
+    start = Clock::now();
+    BigInteger best_cost = run_engine(best.engine, compressed, profile, memory_limit);
+    std::cerr << "dispatch engine=" << best.engine << " predicted_ms=" << best.time_ms
+              << " actual_ms=" << ms_since(start) << '\n';
+
+    std::cout << best_cost << '\n';
+
+    return 0;
+}
@@ -1,59 +1,33 @@
 #include "bigint.hpp"
+#include "standard.hpp"
 
 #include <iostream>
 #include <vector>
-#include <algorithm>
+#include <string>
 
-// number types  ------
+using standard::BigInteger;
+using standard::Item;
 
-using BigInteger = long long;
-using Rational = long double;
+// usage: ./standard [--stats] < in
+// --stats prints counters as JSON to stderr (build with -DKNAPSACK_STATS to collect them)
+int main(int argc, char* argv[]) {
+    bool print_stats = argc > 1 && std::string(argv[1]) == "--stats";
 
-// number types  ------
-
-
-struct Item {
-    BigInteger weight;
-    BigInteger cost;
-};
-
-void relax(BigInteger& old_cost, const BigInteger& new_cost) {
-    if (old_cost < new_cost) // if old_cost was -1, will update correctly
-        old_cost = new_cost;
-}
-
-void update(std::vector<BigInteger>& best_cost, const Item& new_item) {
-    BigInteger max_weight = BigInteger(best_cost.size()) - 1;
-    for (int w = max_weight - new_item.weight; w >= 0; --w)
-        if (best_cost[w] != -1)
-            relax(best_cost[w + new_item.weight], best_cost[w] + new_item.cost);
-}
-
-
-BigInteger get_optimal_cost(
-        int n,
-        BigInteger max_weight,
-        const std::vector<Item>& items) {
-
-    std::vector<BigInteger> best_cost(max_weight + 1, -1);
-    best_cost[0] = 0;
-
-    for (int i = 0; i < n; ++i)
-        update(best_cost, items[i]);
-    return *std::max_element(best_cost.begin(), best_cost.end());
-}
-
-int main() {
     int n;
     BigInteger max_weight;
     std::cin >> n >> max_weight;
+    STATS_SET(n, n);
+    STATS_SET(max_weight, max_weight);
 
     std::vector<Item> items(n);
     for (int i = 0; i < n; ++i) {
         std::cin >> items[i].weight >> items[i].cost;
     }
 
-    std::cout << get_optimal_cost(n, max_weight , items) << '\n';
+    std::cout << standard::get_optimal_cost(n, max_weight , items) << '\n';
+
+    if (print_stats)
+        std::cerr << stats::to_json() << '\n';
 
     return 0;
 }
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "subset_sum.hpp"
+#include "stats.hpp"
+
+#include <vector>
+#include <algorithm>
+
+namespace standard {
+
+// number types  ------
+
+using BigInteger = long long;
+using Rational = long double;
+
+// number types  ------
+
+
+struct Item {
+    BigInteger weight;
+    BigInteger cost;
+};
+
+inline void relax(BigInteger& old_cost, const BigInteger& new_cost) {
+    if (old_cost < new_cost) { // if old_cost was -1, will update correctly
+        old_cost = new_cost;
+        STATS_ADD(states_relaxed, 1);
+    }
+}
+
+inline void update(std::vector<BigInteger>& best_cost, const Item& new_item) {
+    STATS_PHASE(update_states_ms);
+    BigInteger max_weight = BigInteger(best_cost.size()) - 1;
+    STATS_ADD(states_touched, std::max<BigInteger>(0, max_weight - new_item.weight + 1));
+    for (BigInteger w = max_weight - new_item.weight; w >= 0; --w)
+        if (best_cost[w] != -1)
+            relax(best_cost[w + new_item.weight], best_cost[w] + new_item.cost);
+}
+
+// best_cost[w] = max cost of a set with weight exactly w, -1 if there is no such set
+// O(nW) time & O(W) memory
+inline std::vector<BigInteger> get_best_costs(
+        BigInteger max_weight,
+        const std::vector<Item>& items) {
+
+    std::vector<BigInteger> best_cost(max_weight + 1, -1);
+    best_cost[0] = 0;
+    STATS_ADD(bytes_allocated, best_cost.size() * sizeof(BigInteger));
+    STATS_MAX(peak_dp_length, best_cost.size());
+
+    for (const auto& item : items)
+        update(best_cost, item);
+    return best_cost;
+}
+
+inline BigInteger get_optimal_cost(
+        int n,
+        BigInteger max_weight,
+        const std::vector<Item>& items) {
+
+    std::vector<BigInteger> weights(n), costs(n);
+    for (int i = 0; i < n; ++i) {
+        weights[i] = items[i].weight;
+        costs[i] = items[i].cost;
+    }
+    if (subset_sum::is_subset_sum(weights, costs))
+        return subset_sum::get_max_subset_sum(max_weight, weights);
+
+    std::vector<BigInteger> best_cost = get_best_costs(max_weight, items);
+    return *std::max_element(best_cost.begin(), best_cost.end());
+}
+
+} // namespace standard
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+
+// Hot-path counters and phase timers of the solvers. They are compiled in only
+// with -DKNAPSACK_STATS, otherwise the STATS_* macros expand to nothing.
+
+namespace stats {
+
+struct Stats {
+    // instance shape
+    long long n = 0;
+    long long max_weight = 0;
+    long double precision = 0;        // guaranteed by the run, may be above the requested one
+    long double reduction_coef = 0;   // 0 if costs were not reduced
+
+    // phases, ms
+    double reduce_cost_ms = 0;
+    double resize_for_update_ms = 0;  // part of update_states_ms
+    double update_states_ms = 0;
+    double subset_sum_ms = 0;
+
+    long long states_touched = 0;     // dp cells (bitset words for subset-sum) scanned
+    long long states_relaxed = 0;     // dp cells improved
+    long long peak_dp_length = 0;
+    long long reallocations = 0;
+    long long bytes_allocated = 0;
+};
+
+// per thread, so solvers running in parallel do not race on the counters
+inline Stats& get() {
+    thread_local Stats stats;
+    return stats;
+}
+
+// adds the time of its scope to a phase
+class PhaseTimer {
+private:
+    double& phase_ms;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit PhaseTimer(double& phase_ms) : phase_ms(phase_ms), start(std::chrono::steady_clock::now()) {}
+
+    ~PhaseTimer() {
+        phase_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+inline std::string to_json() {
+    std::ostringstream out;
+#ifdef KNAPSACK_STATS
+    const Stats& stats = get();
+    out << "{\"enabled\": true"
+        << ", \"n\": " << stats.n
+        << ", \"max_weight\": " << stats.max_weight
+        << ", \"precision\": " << stats.precision
+        << ", \"reduction_coef\": " << stats.reduction_coef
+        << ", \"reduce_cost_ms\": " << stats.reduce_cost_ms
+        << ", \"resize_for_update_ms\": " << stats.resize_for_update_ms
+        << ", \"update_states_ms\": " << stats.update_states_ms
+        << ", \"subset_sum_ms\": " << stats.subset_sum_ms
+        << ", \"states_touched\": " << stats.states_touched
+        << ", \"states_relaxed\": " << stats.states_relaxed
+        << ", \"peak_dp_length\": " << stats.peak_dp_length
+        << ", \"reallocations\": " << stats.reallocations
+        << ", \"bytes_allocated\": " << stats.bytes_allocated
+        << "}";
+#else
+    out << "{\"enabled\": false}";
+#endif
+    return out.str();
+}
+
+} // namespace stats
+
+#ifdef KNAPSACK_STATS
+#define STATS_PHASE(phase) stats::PhaseTimer stats_timer_##phase(stats::get().phase)
+#define STATS_ADD(counter, value) (stats::get().counter += (value))
+#define STATS_SET(counter, value) (stats::get().counter = (value))
+#define STATS_MAX(counter, value) (stats::get().counter = std::max<long long>(stats::get().counter, (value)))
+#else
+#define STATS_PHASE(phase)
+#define STATS_ADD(counter, value) ((void)0)
+#define STATS_SET(counter, value) ((void)0)
+#define STATS_MAX(counter, value) ((void)0)
+#endif
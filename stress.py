@@ -4,6 +4,8 @@ import random
 stupid = "standard"
 smart = "main"
 gen = "gen"
+sharded = "sharded"
+dispatcher = "solve"
 
 class Rational:
     def __init__(self, numerator, denominator):
@@ -19,18 +21,41 @@ def RatioGreaterThanOnePlusEpsilon(numerator, denominator, epsilon):
         return numerator > denominator * (1 + epsilon)
 
 
+def MaxSubsetSum(text):
+    # reference answer for cost == weight instances: reach |= reach << w on python ints
+    tokens = text.split()
+    n, max_weight = int(tokens[0]), int(tokens[1])
+    reach = 1
+    for i in range(n):
+        reach |= reach << int(tokens[2 + 2 * i])
+    reach &= (1 << (max_weight + 1)) - 1
+    return reach.bit_length() - 1
+
+
 def compile(a):
-    return "g++ -std=c++17 ./" + a + ".cpp -o " + a
+    return "g++ -std=c++17 -O3 -pthread ./" + a + ".cpp -o " + a
 
 def main():
-    os.system("clear && " + compile(stupid) + " && " + compile(smart) + " && " + compile(gen))
+    os.system("clear && " + compile(stupid) + " && " + compile(smart) + " && " + compile(gen) + " && " + compile(sharded) + " && " + compile(dispatcher))
     for te in range(1000000):
         precision = random.random()
-        os.system("./" + gen + " " + str(te) + f" n=100 max_weight=500 cost=10000 precision={precision} " + " > in")
+        subset_sum = te % 2
+        max_weight = 500 if te % 50 != 1 else 1 << 23  # large W exercises the block-parallel bitset
+        os.system("./" + gen + " " + str(te) + f" n=100 max_weight={max_weight} cost=10000 precision={precision} subset_sum={subset_sum} " + " > in")
         RE1 = os.system("./" + stupid + " < in > out")
         ans = int(open("out", 'r').read())
+        expected = MaxSubsetSum(open("in", 'r').read()) if subset_sum else ans
         RE2 = os.system("./" + smart + " < in > out")
         out = int(open("out", 'r').read())
+        RE3 = os.system("./" + sharded + f" workers={te % 5 + 1} < in > out 2> /dev/null")
+        sharded_out = int(open("out", 'r').read())
+        budget = random.choice([1000, 10000, 100000, 10000000])
+        RE5 = os.system("./" + smart + f" --memory-budget={budget} < in > out")
+        budgeted_out, effective_precision = open("out", 'r').read().split()
+        budgeted_out = int(budgeted_out)
+        effective_precision = float(effective_precision.split("=")[1])
+        RE4 = os.system("./" + dispatcher + " < in > out 2> /dev/null")
+        dispatcher_out = int(open("out", 'r').read())
 
         flag = 0
 
@@ -40,6 +65,35 @@ def main():
         if RE2:
             flag = 1
             print("RE " + smart)
+        if RE3:
+            flag = 1
+            print("RE " + sharded)
+        if sharded_out != ans:
+            flag = 1
+            print("WA " + sharded)
+            print("Correct ans:", ans, sep="\n")
+            print("Output:", sharded_out, sep="\n")
+        if RE4:
+            flag = 1
+            print("RE " + dispatcher)
+        if dispatcher_out > ans or RatioGreaterThanOnePlusEpsilon(ans, dispatcher_out, precision):
+            flag = 1
+            print("WA " + dispatcher)
+            print("Correct ans:", ans, sep="\n")
+            print("Output:", dispatcher_out, sep="\n")
+        if RE5:
+            flag = 1
+            print("RE " + smart + " --memory-budget")
+        if budgeted_out > ans or RatioGreaterThanOnePlusEpsilon(ans, budgeted_out, effective_precision):
+            flag = 1
+            print("WA " + smart + f" --memory-budget={budget}, effective precision {effective_precision}")
+            print("Correct ans:", ans, sep="\n")
+            print("Output:", budgeted_out, sep="\n")
+        if ans != expected:
+            flag = 1
+            print("WA " + stupid)
+            print("Correct ans:", expected, sep="\n")
+            print("Output:", ans, sep="\n")
         if RatioGreaterThanOnePlusEpsilon(ans, out, precision):
         # if ans != out:
             flag = 1
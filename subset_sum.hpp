@@ -0,0 +1,196 @@
+#pragma once
+
+#include "stats.hpp"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+
+// Subset-sum fast path: when cost == weight for every item the knapsack
+// reduces to "largest reachable sum <= W", which is a bitset DP
+// reach |= reach << w on 64-bit words.
+
+namespace subset_sum {
+
+using Word = uint64_t;
+
+const size_t word_bits = 64;
+const size_t parallel_min_words = 1 << 16;  // below this threads cost more than they save
+
+template <typename Number>
+bool is_subset_sum(const std::vector<Number>& weights, const std::vector<Number>& costs) {
+    for (size_t i = 0; i < weights.size(); ++i)
+        if (weights[i] != costs[i])
+            return false;
+    return true;
+}
+
+// Sums above min(W, sum of weights) are never reachable, no need to store them
+template <typename Number>
+Number get_bitset_capacity(const Number& max_weight, const std::vector<Number>& weights) {
+    Number total_weight = 0;
+    for (const auto& weight : weights) {
+        if (weight >= max_weight - total_weight)  // total_weight + weight may overflow
+            return max_weight;
+        total_weight += weight;
+    }
+    return total_weight;
+}
+
+// bitset and the second buffer of the block-parallel variant
+template <typename Number>
+Number get_bitset_bytes(const Number& max_weight, const std::vector<Number>& weights) {
+    return Number(2 * sizeof(Word)) * (get_bitset_capacity(max_weight, weights) / Number(word_bits) + 1);
+}
+
+// reach |= reach << shift, in place: going from the top word down
+// every source word is read before it is overwritten, so a vector of words
+// loaded before it is stored gives the same result and ivdep is safe
+inline void shift_or(std::vector<Word>& reach, size_t shift) {
+    size_t word_shift = shift / word_bits, bit_shift = shift % word_bits;
+    if (word_shift >= reach.size())
+        return;
+    Word* data = reach.data();
+    size_t count = reach.size() - word_shift - 1;  // words above the boundary word_shift
+    Word* dest = data + word_shift + 1;
+    if (bit_shift == 0) {
+#pragma GCC ivdep
+        for (size_t j = count; j-- > 0;)
+            dest[j] |= data[j + 1];
+        data[word_shift] |= data[0];
+    } else {
+#pragma GCC ivdep
+        for (size_t j = count; j-- > 0;)
+            dest[j] |= (data[j + 1] << bit_shift) | (data[j] >> (word_bits - bit_shift));
+        data[word_shift] |= data[0] << bit_shift;
+    }
+}
+
+// dest[i] = src[i] | (src << shift)[i] for i in [from, to), the buffers do not overlap.
+// Words below the shift and the boundary word are split off, so the main loop is
+// straight-line and vectorizes (SSE2 at -O3, AVX2 with -march=native)
+inline void shift_or_range(
+        const Word* __restrict src, Word* __restrict dest,
+        size_t from, size_t to, size_t word_shift, size_t bit_shift) {
+
+    size_t i = from;
+    for (; i < to && i < word_shift; ++i)
+        dest[i] = src[i];
+    if (i < to && i == word_shift) {
+        dest[i] = src[i] | (src[0] << bit_shift);
+        ++i;
+    }
+    if (bit_shift == 0) {
+        for (; i < to; ++i)
+            dest[i] = src[i] | src[i - word_shift];
+    } else {
+        for (; i < to; ++i)
+            dest[i] = src[i] | (src[i - word_shift] << bit_shift) | (src[i - word_shift - 1] >> (word_bits - bit_shift));
+    }
+}
+
+inline void mask_tail(std::vector<Word>& reach, size_t bits) {
+    if (bits % word_bits != 0)
+        reach.back() &= (Word(1) << (bits % word_bits)) - 1;
+}
+
+inline long long highest_set_bit(const std::vector<Word>& reach) {
+    for (size_t i = reach.size(); i-- > 0;)
+        if (reach[i] != 0)
+            return i * word_bits + (word_bits - 1 - __builtin_clzll(reach[i]));
+    return -1;
+}
+
+// Sense-reversing barrier, the items are processed in lockstep by all workers
+class SpinBarrier {
+private:
+    const size_t threads;
+    std::atomic<size_t> waiting{0};
+    std::atomic<bool> sense{false};
+
+public:
+    explicit SpinBarrier(size_t threads) : threads(threads) {}
+
+    void wait() {
+        bool my_sense = !sense.load(std::memory_order_relaxed);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == threads) {
+            waiting.store(0, std::memory_order_relaxed);
+            sense.store(my_sense, std::memory_order_release);
+        } else {
+            while (sense.load(std::memory_order_acquire) != my_sense)
+                std::this_thread::yield();
+        }
+    }
+};
+
+// Block-parallel variant: every worker owns a contiguous range of words and
+// writes next = cur | (cur << w) for it; the buffers are swapped after a barrier.
+// O(n * W / (64 * threads)) time & O(W / 32) memory
+inline void run_parallel(std::vector<Word>& reach, size_t bits, const std::vector<size_t>& shifts, size_t threads) {
+    std::vector<Word> next(reach.size());
+    STATS_ADD(bytes_allocated, next.size() * sizeof(Word));
+    SpinBarrier barrier(threads);
+    size_t block = (reach.size() + threads - 1) / threads;
+
+    auto worker = [&](size_t id) {
+        size_t from = std::min(reach.size(), id * block), to = std::min(reach.size(), from + block);
+        Word* cur = reach.data();
+        Word* dest = next.data();
+        for (size_t shift : shifts) {
+            size_t word_shift = shift / word_bits, bit_shift = shift % word_bits;
+            shift_or_range(cur, dest, from, to, word_shift, bit_shift);
+            if (to == reach.size() && from < to && bits % word_bits != 0)
+                dest[to - 1] &= (Word(1) << (bits % word_bits)) - 1;
+            std::swap(cur, dest);
+            barrier.wait();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t id = 1; id < threads; ++id)
+        workers.emplace_back(worker, id);
+    worker(0);
+    for (auto& thread : workers)
+        thread.join();
+
+    if (shifts.size() % 2 == 1)
+        reach.swap(next);
+}
+
+// Largest reachable sum <= max_weight, the block-parallel variant runs from min_parallel_words words
+// O(n * W / 64) time & O(W / 64) memory
+template <typename Number>
+Number get_max_subset_sum(
+        const Number& max_weight,
+        const std::vector<Number>& weights,
+        size_t threads = std::thread::hardware_concurrency(),
+        size_t min_parallel_words = parallel_min_words) {
+
+    STATS_PHASE(subset_sum_ms);
+    Number capacity = get_bitset_capacity(max_weight, weights);
+    size_t bits = size_t(capacity) + 1;
+    std::vector<Word> reach((bits + word_bits - 1) / word_bits, 0);
+    reach[0] = 1;
+    STATS_ADD(bytes_allocated, reach.size() * sizeof(Word));
+    STATS_MAX(peak_dp_length, reach.size());
+
+    std::vector<size_t> shifts;
+    for (const auto& weight : weights)
+        if (weight > 0 && weight <= capacity)
+            shifts.push_back(size_t(weight));
+
+    STATS_ADD(states_touched, shifts.size() * reach.size());
+    if (threads > 1 && reach.size() >= min_parallel_words) {
+        run_parallel(reach, bits, shifts, std::min(threads, reach.size() / min_parallel_words + 1));
+    } else {
+        for (size_t shift : shifts) {
+            shift_or(reach, shift);
+            mask_tail(reach, bits);
+        }
+    }
+    return Number(highest_set_bit(reach));
+}
+
+} // namespace subset_sum